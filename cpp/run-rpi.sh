@@ -41,6 +41,9 @@ show_help() {
     echo "Options:"
     echo "  --size N      Array size (1-10000, default: 100)"
     echo "  --delay MS    Delay in milliseconds (0-1000, default: 10)"
+    echo "  --track-allocs  Report heap and SDL allocations"
+    echo "  --perf          Report hardware counters for the sort"
+    echo "  --perf-json F   Also save the counters to JSON file F"
     echo "  --no-build    Skip building, run existing binary"
     echo "  --help, -h    Show this help message"
     echo ""
@@ -73,11 +76,11 @@ while [[ $# -gt 0 ]]; do
             ALGORITHM=$1
             shift
             ;;
-        --size=*|--delay=*)
+        --size=*|--delay=*|--perf-json=*|--track-allocs|--perf)
             EXTRA_ARGS+=("$1")
             shift
             ;;
-        --size|--delay)
+        --size|--delay|--perf-json)
             EXTRA_ARGS+=("$1")
             if [[ $# -gt 1 ]]; then
                 EXTRA_ARGS+=("$2")
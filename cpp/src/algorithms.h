@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include "visualizer.h"
+#include "perf_counters.h"
 
 // Enum for available sorting algorithms
 enum class SortAlgorithm {
@@ -0,0 +1,381 @@
+#include "alloc_tracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <vector>
+
+// Every block handed out by operator new starts with this header, so delete
+// knows how many bytes (and which category) to give back.
+struct BlockHeader {
+    size_t size;
+    uint32_t category;
+    uint32_t tracked;
+};
+
+// Round the header up so the pointer we return keeps malloc's alignment
+const size_t HEADER_SIZE =
+    (sizeof(BlockHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+const int CATEGORY_COUNT = 3;
+const int MAX_SITES = 256;
+const int MAX_FRAMES = 24;  // How far up the stack we look (unoptimized std:: call chains are deep)
+
+// One place in our code that (directly or through the standard library) calls operator new
+struct AllocSite {
+    void* address;
+    int category;
+    size_t count;
+    size_t bytes;
+    size_t hotLoopCount;
+};
+
+// All of these are plain data so they work before main() starts
+static std::atomic<bool> g_enabled(false);
+static std::mutex g_mutex;
+static AllocStats g_stats[CATEGORY_COUNT];
+static AllocSite g_sites[MAX_SITES];
+static size_t g_droppedSites = 0;
+
+static thread_local int t_category = static_cast<int>(AllocCategory::OTHER);
+static thread_local bool t_inHotLoop = false;
+static thread_local bool t_busy = false;  // Don't count our own allocations
+
+// Load address of the sort_visualizer executable, so we can tell our code
+// apart from libstdc++ and SDL when walking the stack
+static void* g_executableBase = nullptr;
+
+static const char* categoryName(int category) {
+    switch (static_cast<AllocCategory>(category)) {
+        case AllocCategory::SORT:   return "Sort";
+        case AllocCategory::RENDER: return "Render";
+        default:                    return "Other";
+    }
+}
+
+static void recordSite(void* address, int category, size_t size, bool hot) {
+    size_t slot = (reinterpret_cast<uintptr_t>(address) >> 2) % MAX_SITES;
+    for (int probe = 0; probe < MAX_SITES; probe++) {
+        AllocSite& site = g_sites[(slot + probe) % MAX_SITES];
+        if (site.address == nullptr) {
+            site.address = address;
+            site.category = category;
+        }
+        if (site.address == address && site.category == category) {
+            site.count++;
+            site.bytes += size;
+            if (hot) site.hotLoopCount++;
+            return;
+        }
+    }
+    g_droppedSites++;  // Table is full
+}
+
+// Is this function name operator new (or new[])?
+static bool isOperatorNew(const char* mangledName) {
+    return std::strncmp(mangledName, "_Znw", 4) == 0 || std::strncmp(mangledName, "_Zna", 4) == 0;
+}
+
+// Is this function name from the standard library (std::string, std::vector, ...)?
+static bool isStandardLibrary(const char* mangledName) {
+    static const char* prefixes[] = {"_ZNSt", "_ZNKSt", "_ZSt", "_ZNSa", "_ZNKSa", "_ZN9__gnu_cxx"};
+    for (const char* prefix : prefixes) {
+        size_t length = std::strlen(prefix);
+        if (std::strncmp(mangledName, prefix, length) == 0) return true;
+    }
+    return false;
+}
+
+// Find the allocation site: the first stack frame in our executable that
+// isn't standard library code. For a std::string built in draw() this is
+// the line in draw(), not the libstdc++ function that called operator new.
+// Function names come from the executable's exported symbols, which is why
+// CMakeLists.txt builds with ENABLE_EXPORTS (-rdynamic).
+// Frame 0 is this function; frame 1 is operator new (trackedAlloc is inlined into it).
+__attribute__((noinline)) static void* findCaller() {
+    void* frames[MAX_FRAMES];
+    int count = backtrace(frames, MAX_FRAMES);
+
+    void* firstOurs = nullptr;
+    for (int i = 2; i < count; i++) {
+        Dl_info info;
+        if (!dladdr(frames[i], &info) || info.dli_fbase != g_executableBase) continue;
+        if (info.dli_sname && isOperatorNew(info.dli_sname)) continue;
+        if (info.dli_sname && isStandardLibrary(info.dli_sname)) {
+            if (!firstOurs) firstOurs = frames[i];  // Inlined into our binary - keep looking
+            continue;
+        }
+        return frames[i];
+    }
+    if (firstOurs) return firstOurs;
+    return count > 2 ? frames[2] : nullptr;
+}
+
+__attribute__((always_inline)) static inline void* trackedAlloc(size_t size) {
+    if (size == 0) size = 1;
+    void* raw = std::malloc(size + HEADER_SIZE);
+    if (!raw) return nullptr;
+
+    BlockHeader* header = static_cast<BlockHeader*>(raw);
+    header->size = size;
+    header->category = t_category;
+    header->tracked = 0;
+
+    if (g_enabled.load(std::memory_order_relaxed) && !t_busy) {
+        t_busy = true;  // backtrace() may allocate
+        void* caller = findCaller();
+        t_busy = false;
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        AllocStats& stats = g_stats[t_category];
+        stats.allocations++;
+        stats.totalBytes += size;
+        stats.currentBytes += size;
+        stats.peakBytes = std::max(stats.peakBytes, stats.currentBytes + stats.sdlCurrentBytes);
+        if (t_inHotLoop) stats.hotLoopAllocations++;
+        recordSite(caller, t_category, size, t_inHotLoop);
+        header->tracked = 1;
+    }
+
+    return static_cast<char*>(raw) + HEADER_SIZE;
+}
+
+static void trackedFree(void* ptr) {
+    if (!ptr) return;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - HEADER_SIZE);
+
+    if (header->tracked) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        AllocStats& stats = g_stats[header->category];
+        stats.currentBytes -= std::min(stats.currentBytes, header->size);
+    }
+
+    std::free(header);
+}
+
+void AllocTracker::enable() {
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(&categoryName), &info)) {
+        g_executableBase = info.dli_fbase;
+    }
+
+    // The first backtrace() call loads libgcc, so get that out of the way now
+    void* frames[1];
+    backtrace(frames, 1);
+
+    g_enabled.store(true);
+}
+
+bool AllocTracker::isEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::reset(AllocCategory category) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    AllocStats& stats = g_stats[static_cast<int>(category)];
+    size_t live = stats.currentBytes;
+    size_t sdlLive = stats.sdlCurrentBytes;
+    stats = AllocStats();
+    stats.currentBytes = live;
+    stats.sdlCurrentBytes = sdlLive;
+    stats.sdlPeakBytes = sdlLive;
+    stats.peakBytes = live + sdlLive;
+}
+
+AllocStats AllocTracker::getStats(AllocCategory category) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_stats[static_cast<int>(category)];
+}
+
+// SDL objects always count as rendering
+static void recordSdlObject(size_t bytes, bool texture) {
+    if (!AllocTracker::isEnabled()) return;
+    std::lock_guard<std::mutex> lock(g_mutex);
+    AllocStats& stats = g_stats[static_cast<int>(AllocCategory::RENDER)];
+    if (texture) {
+        stats.sdlTextures++;
+    } else {
+        stats.sdlSurfaces++;
+    }
+    stats.sdlBytes += bytes;
+    stats.sdlCurrentBytes += bytes;
+    stats.sdlPeakBytes = std::max(stats.sdlPeakBytes, stats.sdlCurrentBytes);
+    stats.peakBytes = std::max(stats.peakBytes, stats.currentBytes + stats.sdlCurrentBytes);
+    if (t_inHotLoop) stats.hotLoopAllocations++;
+}
+
+static void releaseSdlObject(size_t bytes) {
+    if (!AllocTracker::isEnabled()) return;
+    std::lock_guard<std::mutex> lock(g_mutex);
+    AllocStats& stats = g_stats[static_cast<int>(AllocCategory::RENDER)];
+    stats.sdlCurrentBytes -= std::min(stats.sdlCurrentBytes, bytes);
+}
+
+void AllocTracker::recordSdlSurface(size_t bytes) {
+    recordSdlObject(bytes, false);
+}
+
+void AllocTracker::releaseSdlSurface(size_t bytes) {
+    releaseSdlObject(bytes);
+}
+
+void AllocTracker::recordSdlTexture(size_t bytes) {
+    recordSdlObject(bytes, true);
+}
+
+void AllocTracker::releaseSdlTexture(size_t bytes) {
+    releaseSdlObject(bytes);
+}
+
+std::string AllocTracker::formatBytes(size_t bytes) {
+    char buffer[32];
+    if (bytes < 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%zu B", bytes);
+    } else if (bytes < 1024 * 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+    }
+    return buffer;
+}
+
+// Turn a return address into "module+0x1234 function" so addr2line can find it
+static std::string describeAddress(void* address) {
+    std::stringstream ss;
+
+    Dl_info info;
+    if (!dladdr(address, &info) || !info.dli_fname) {
+        ss << address;
+        return ss.str();
+    }
+
+    std::string module = info.dli_fname;
+    size_t slash = module.find_last_of('/');
+    if (slash != std::string::npos) module = module.substr(slash + 1);
+    ss << module << "+0x" << std::hex
+       << (static_cast<char*>(address) - static_cast<char*>(info.dli_fbase));
+
+    if (info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = (status == 0 && demangled) ? demangled : info.dli_sname;
+        std::free(demangled);
+        if (name.size() > 60) name = name.substr(0, 57) + "...";
+        ss << " " << name;
+    }
+    return ss.str();
+}
+
+void AllocTracker::printReport() {
+    if (!isEnabled()) return;
+
+    // Copy everything first so printing doesn't change the numbers
+    AllocStats stats[CATEGORY_COUNT];
+    std::vector<AllocSite> sites;
+    size_t dropped;
+    t_busy = true;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        std::copy(g_stats, g_stats + CATEGORY_COUNT, stats);
+        for (const AllocSite& site : g_sites) {
+            if (site.address) sites.push_back(site);
+        }
+        dropped = g_droppedSites;
+    }
+
+    std::cout << "\n========================================\n";
+    std::cout << "Allocation Report\n";
+    std::cout << "========================================\n";
+    for (int c = 0; c < CATEGORY_COUNT; c++) {
+        std::cout << categoryName(c) << ": "
+                  << stats[c].allocations << " allocations, "
+                  << formatBytes(stats[c].totalBytes) << " total, "
+                  << formatBytes(stats[c].peakBytes) << " peak\n";
+        if (stats[c].hotLoopAllocations > 0) {
+            std::cout << "  WARNING: " << stats[c].hotLoopAllocations
+                      << " allocations inside the per-step loop\n";
+        }
+        if (stats[c].sdlSurfaces > 0 || stats[c].sdlTextures > 0) {
+            std::cout << "  SDL: " << stats[c].sdlSurfaces << " surfaces, "
+                      << stats[c].sdlTextures << " textures, "
+                      << formatBytes(stats[c].sdlBytes) << " of pixels, "
+                      << formatBytes(stats[c].sdlPeakBytes) << " peak\n";
+        }
+    }
+
+    // Busiest call sites first
+    std::sort(sites.begin(), sites.end(), [](const AllocSite& a, const AllocSite& b) {
+        return a.count > b.count;
+    });
+
+    std::cout << "\nHot allocation sites:\n";
+    for (size_t i = 0; i < sites.size() && i < 10; i++) {
+        const AllocSite& site = sites[i];
+        std::cout << "  " << categoryName(site.category) << "  "
+                  << site.count << "x, " << formatBytes(site.bytes)
+                  << (site.hotLoopCount > 0 ? "  [hot loop]" : "")
+                  << "  " << describeAddress(site.address) << "\n";
+    }
+    if (dropped > 0) {
+        std::cout << "  (" << dropped << " allocations from untracked sites)\n";
+    }
+    std::cout << "Tip: addr2line -C -f -i -e sort_visualizer 0x<offset> shows the source line\n";
+    std::cout << "     (sites in other modules, e.g. libstdc++, need that library instead)\n";
+    std::cout << "========================================\n";
+    t_busy = false;
+}
+
+AllocTracker::Scope::Scope(AllocCategory category) : previous(static_cast<AllocCategory>(t_category)) {
+    t_category = static_cast<int>(category);
+}
+
+AllocTracker::Scope::~Scope() {
+    t_category = static_cast<int>(previous);
+}
+
+AllocTracker::HotLoop::HotLoop() : previous(t_inHotLoop) {
+    t_inHotLoop = true;
+}
+
+AllocTracker::HotLoop::~HotLoop() {
+    t_inHotLoop = previous;
+}
+
+// Global operator new/delete replacements
+// (the aligned overloads keep the standard library's own implementation)
+
+void* operator new(size_t size) {
+    void* ptr = trackedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    void* ptr = trackedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return trackedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return trackedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
@@ -0,0 +1,87 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <string>
+
+// Which part of the program an allocation belongs to
+enum class AllocCategory {
+    OTHER,   // Setup, tone generation, anything outside a sort
+    SORT,    // The sorting algorithm itself
+    RENDER,  // Drawing a frame (text, stringstreams, SDL surfaces)
+};
+
+// Totals for one category
+struct AllocStats {
+    size_t allocations = 0;     // Number of operator new calls
+    size_t totalBytes = 0;      // Bytes requested over the whole run
+    size_t currentBytes = 0;    // Bytes still alive right now
+    size_t peakBytes = 0;       // Most bytes alive at the same time (heap + SDL)
+    size_t hotLoopAllocations = 0;  // Allocations (heap or SDL) made inside the per-step loop
+    size_t sdlSurfaces = 0;     // SDL surfaces created (RENDER only)
+    size_t sdlTextures = 0;     // SDL textures created (RENDER only)
+    size_t sdlBytes = 0;        // Pixel bytes of those surfaces/textures
+    size_t sdlCurrentBytes = 0; // SDL pixel bytes still alive right now
+    size_t sdlPeakBytes = 0;    // Most SDL pixel bytes alive at the same time
+};
+
+// Opt-in allocation tracker (enable with --track-allocs)
+//
+// Replaces the global operator new/delete so every heap allocation is counted.
+// When tracking is off the hooks only add a small header to each block, so
+// normal runs are not slowed down.
+//
+// Usage inside an algorithm:
+//   AllocTracker::Scope scope(AllocCategory::SORT);   // everything below is "sort work"
+//   for (...) {
+//       AllocTracker::HotLoop hot;                     // flag allocations in this step
+//       ...
+//   }
+class AllocTracker {
+public:
+    // Turn tracking on (call once, before the sort starts)
+    static void enable();
+    static bool isEnabled();
+
+    // Forget the numbers for one category (e.g. at the start of a sort)
+    static void reset(AllocCategory category);
+
+    static AllocStats getStats(AllocCategory category);
+
+    // Account for SDL objects, which are allocated with malloc inside SDL.
+    // Call the release function with the same size when the object is freed.
+    static void recordSdlSurface(size_t bytes);
+    static void releaseSdlSurface(size_t bytes);
+    static void recordSdlTexture(size_t bytes);
+    static void releaseSdlTexture(size_t bytes);
+
+    // "1.5 KB", "320 B", ...
+    static std::string formatBytes(size_t bytes);
+
+    // Print per-category totals and the busiest allocation sites
+    static void printReport();
+
+    // Marks everything allocated while it is alive as belonging to a category
+    class Scope {
+    public:
+        explicit Scope(AllocCategory category);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        AllocCategory previous;
+    };
+
+    // Marks one step of the per-comparison loop, where allocating is a smell
+    class HotLoop {
+    public:
+        HotLoop();
+        ~HotLoop();
+        HotLoop(const HotLoop&) = delete;
+        HotLoop& operator=(const HotLoop&) = delete;
+    private:
+        bool previous;
+    };
+};
+
+#endif // ALLOC_TRACKER_H
@@ -3,6 +3,25 @@
 #include <chrono>
 #include <iostream>
 
+// The bubble sort logic on its own - no drawing, sound or delays.
+// Used to replay the run so the hardware counters see only the algorithm.
+// Counts comparisons and swaps so we can check it did the same work.
+static void bubbleSortKernel(std::vector<int>& array, int& comparisons, int& swaps) {
+    int n = array.size();
+    for (int i = 0; i < n - 1; i++) {
+        bool swapped = false;
+        for (int j = 0; j < n - i - 1; j++) {
+            comparisons++;
+            if (array[j] > array[j + 1]) {
+                std::swap(array[j], array[j + 1]);
+                swapped = true;
+                swaps++;
+            }
+        }
+        if (!swapped) break;
+    }
+}
+
 // Bubble Sort with visualization
 // Time Complexity: O(n^2) - quadratic
 // Space Complexity: O(1) - constant
@@ -13,7 +32,13 @@
 // 3. Repeat until no more swaps needed
 void bubbleSort(std::vector<int>& array, Visualizer& viz) {
     int n = array.size();
-    std::vector<bool> sorted(n, false);
+    std::vector<bool> sorted(n, false);  // Only for drawing, not part of the algorithm
+    std::vector<int> perfInput;           // Copy of the input to replay for the counters
+    if (PerfCounters::isEnabled()) perfInput = array;
+
+    // Measure only what the algorithm itself allocates
+    AllocTracker::reset(AllocCategory::SORT);
+    AllocTracker::Scope allocScope(AllocCategory::SORT);
     int totalComparisons = 0;
     int totalSwaps = 0;
     auto startTime = std::chrono::high_resolution_clock::now();
@@ -34,6 +59,7 @@ void bubbleSort(std::vector<int>& array, Visualizer& viz) {
         std::cout << "Pass " << (i + 1) << "/" << (n - 1) << "... ";
 
         for (int j = 0; j < n - i - 1; j++) {
+            AllocTracker::HotLoop hotLoop;  // One step - nothing here should allocate
             totalComparisons++;
             passComparisons++;
             // Check for quit
@@ -74,6 +100,25 @@ void bubbleSort(std::vector<int>& array, Visualizer& viz) {
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
+    // Replay the same input in one counting window, without the visualization
+    bool replayMatches = false;
+    if (PerfCounters::isEnabled()) {
+        int replayComparisons = 0;
+        int replaySwaps = 0;
+        PerfCounters::reset();
+        {
+            PerfCounters::Scope perfScope;
+            bubbleSortKernel(perfInput, replayComparisons, replaySwaps);
+        }
+        replayMatches = perfInput == array
+            && replayComparisons == totalComparisons
+            && replaySwaps == totalSwaps;
+        if (!replayMatches) {
+            std::cerr << "Warning: replay for hardware counters did different work ("
+                      << replayComparisons << " comparisons, " << replaySwaps << " swaps)\n";
+        }
+    }
+
     std::cout << "\n========================================\n";
     std::cout << "Bubble Sort Complete!\n";
     std::cout << "========================================\n";
@@ -82,6 +127,14 @@ void bubbleSort(std::vector<int>& array, Visualizer& viz) {
     std::cout << "Time elapsed: " << duration.count() << "ms\n";
     std::cout << "Time complexity: O(n^2)\n";
     std::cout << "Space complexity: O(1)\n";
+    if (AllocTracker::isEnabled()) {
+        AllocStats sortStats = AllocTracker::getStats(AllocCategory::SORT);
+        std::cout << "Measured space: " << AllocTracker::formatBytes(sortStats.peakBytes)
+                  << " peak, " << sortStats.allocations << " allocations ("
+                  << sortStats.hotLoopAllocations << " in the per-step loop)\n";
+    }
+    PerfCounters::recordRunTotals(totalComparisons, totalSwaps, duration.count(), replayMatches);
+    PerfCounters::printReport();
     std::cout << "========================================\n";
 
     // Final visualization showing all bars in green
@@ -19,6 +19,8 @@ int main(int argc, char* argv[]) {
         SortAlgorithm algorithm = ALGORITHM;
         int arraySize = ARRAY_SIZE;
         int delayMs = DELAY_MS;
+        bool usePerf = false;
+        std::string perfJsonPath;
 
         // Parse command line arguments
         for (int i = 1; i < argc; i++) {
@@ -58,6 +60,23 @@ int main(int argc, char* argv[]) {
                     return 1;
                 }
             }
+            // --track-allocs: count heap and SDL allocations during the run
+            else if (arg == "--track-allocs") {
+                AllocTracker::enable();
+            }
+            // --perf: count CPU cycles, instructions, cache and branch misses
+            else if (arg == "--perf") {
+                usePerf = true;
+            }
+            // --perf-json: also save the counters to a file
+            else if (arg.find("--perf-json=") == 0) {
+                usePerf = true;
+                perfJsonPath = arg.substr(12);
+            }
+            else if (arg == "--perf-json" && i + 1 < argc) {
+                usePerf = true;
+                perfJsonPath = argv[++i];
+            }
         }
 
         std::cout << "\n";
@@ -67,6 +86,12 @@ int main(int argc, char* argv[]) {
         std::cout << "\nAlgorithm: " << algorithmToString(algorithm) << "\n";
         std::cout << "Array Size: " << arraySize << " elements\n";
         std::cout << "Delay: " << delayMs << " ms\n";
+        if (AllocTracker::isEnabled()) {
+            std::cout << "Allocation tracking: on\n";
+        }
+        if (usePerf && PerfCounters::enable()) {
+            std::cout << "Hardware counters: on\n";
+        }
         std::cout << "Initializing...\n";
 
         // Create and shuffle array
@@ -111,6 +136,11 @@ int main(int argc, char* argv[]) {
             // Add more algorithms here as they're implemented!
         }
 
+        AllocTracker::printReport();
+        if (!perfJsonPath.empty()) {
+            PerfCounters::writeJson(perfJsonPath, algorithmToString(algorithm), arraySize, delayMs);
+        }
+
         // Wait a bit before closing
         std::this_thread::sleep_for(std::chrono::milliseconds(2000));
 
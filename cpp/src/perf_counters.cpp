@@ -0,0 +1,306 @@
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const int EVENT_COUNT = static_cast<int>(PerfEvent::COUNT);
+
+// Unoptimized builds turn every array access and swap into a function call,
+// so the counters would mostly measure call overhead
+#ifdef __OPTIMIZE__
+const bool OPTIMIZED_BUILD = true;
+#else
+const bool OPTIMIZED_BUILD = false;
+#endif
+
+static bool g_enabled = false;
+
+// Totals reported by the sort itself, for the benchmark JSON
+static bool g_haveTotals = false;
+static long long g_comparisons = 0;
+static long long g_swaps = 0;
+static long long g_elapsedMs = 0;
+static bool g_replayMatches = false;
+
+bool PerfResults::any() const {
+    for (bool measured : available) {
+        if (measured) return true;
+    }
+    return false;
+}
+
+double PerfResults::ipc() const {
+    if (!has(PerfEvent::CYCLES) || !has(PerfEvent::INSTRUCTIONS) || get(PerfEvent::CYCLES) == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(get(PerfEvent::INSTRUCTIONS)) / get(PerfEvent::CYCLES);
+}
+
+std::string PerfCounters::eventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::CYCLES:        return "cycles";
+        case PerfEvent::INSTRUCTIONS:  return "instructions";
+        case PerfEvent::BRANCH_MISSES: return "branch_misses";
+        case PerfEvent::L1D_MISSES:    return "l1d_read_misses";
+        case PerfEvent::LLC_MISSES:    return "llc_read_misses";
+        default:                       return "unknown";
+    }
+}
+
+bool PerfCounters::isEnabled() {
+    return g_enabled;
+}
+
+#ifdef __linux__
+
+// All counters are opened as one group so they start and stop together
+// with a single ioctl. The first event that opens becomes the leader.
+static int g_leaderFd = -1;
+static std::vector<int> g_fds;
+static std::vector<PerfEvent> g_events;  // Order matches the group read
+static int g_scopeDepth = 0;             // Nested Scopes only toggle once
+static bool g_windowRan = false;         // A Scope has run since the last reset()
+
+static uint64_t cacheConfig(uint64_t cache) {
+    return cache
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+static void describeEvent(PerfEvent event, perf_event_attr& attr) {
+    switch (event) {
+        case PerfEvent::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfEvent::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cacheConfig(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case PerfEvent::LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cacheConfig(PERF_COUNT_HW_CACHE_LL);
+            break;
+        default:
+            break;
+    }
+}
+
+static int openEvent(PerfEvent event, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    describeEvent(event, attr);
+    attr.disabled = (groupFd == -1) ? 1 : 0;  // Only the leader starts stopped
+    attr.exclude_kernel = 1;  // Just our code, not the syscalls that pause/resume us
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP
+        | PERF_FORMAT_TOTAL_TIME_ENABLED
+        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+bool PerfCounters::enable() {
+    if (g_enabled) return true;
+
+    int firstError = 0;
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        PerfEvent event = static_cast<PerfEvent>(e);
+        int fd = openEvent(event, g_leaderFd);
+        if (fd < 0) {
+            if (firstError == 0) firstError = errno;
+            continue;  // This CPU doesn't have it - carry on without it
+        }
+        if (g_leaderFd == -1) g_leaderFd = fd;
+        g_fds.push_back(fd);
+        g_events.push_back(event);
+    }
+
+    if (g_leaderFd == -1) {
+        std::cerr << "Hardware counters unavailable: " << std::strerror(firstError) << "\n";
+        if (firstError == EACCES || firstError == EPERM) {
+            std::cerr << "Try: sudo sysctl kernel.perf_event_paranoid=1\n";
+        }
+        return false;
+    }
+
+    g_enabled = true;
+    return true;
+}
+
+void PerfCounters::reset() {
+    if (!g_enabled) return;
+    ioctl(g_leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    g_windowRan = false;
+}
+
+PerfResults PerfCounters::read() {
+    PerfResults results;
+    if (!g_enabled || !g_windowRan) return results;
+
+    // Layout: nr, time_enabled, time_running, value[nr]
+    std::vector<uint64_t> buffer(3 + g_events.size());
+    ssize_t bytes = ::read(g_leaderFd, buffer.data(), buffer.size() * sizeof(uint64_t));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) return results;
+
+    uint64_t count = buffer[0];
+    uint64_t timeEnabled = buffer[1];
+    uint64_t timeRunning = buffer[2];
+
+    // Enabled but never scheduled on the hardware - the zeros mean nothing
+    if (timeRunning == 0) return results;
+
+    // If the kernel had to share the hardware, scale up to an estimate
+    double scale = 1.0;
+    if (timeRunning > 0 && timeRunning < timeEnabled) {
+        scale = static_cast<double>(timeEnabled) / timeRunning;
+        results.multiplexed = true;
+    }
+
+    for (size_t i = 0; i < count && i < g_events.size(); i++) {
+        int e = static_cast<int>(g_events[i]);
+        results.available[e] = true;
+        results.values[e] = static_cast<uint64_t>(buffer[3 + i] * scale);
+    }
+    return results;
+}
+
+PerfCounters::Scope::Scope() {
+    if (g_enabled && g_scopeDepth++ == 0) {
+        ioctl(g_leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        g_windowRan = true;
+    }
+}
+
+PerfCounters::Scope::~Scope() {
+    if (g_enabled && --g_scopeDepth == 0) {
+        ioctl(g_leaderFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+#else  // Not Linux: perf_event_open doesn't exist, so counters are never available
+
+bool PerfCounters::enable() {
+    std::cerr << "Hardware counters are only supported on Linux\n";
+    return false;
+}
+
+void PerfCounters::reset() {}
+
+PerfResults PerfCounters::read() {
+    return PerfResults();
+}
+
+PerfCounters::Scope::Scope() {}
+
+PerfCounters::Scope::~Scope() {}
+
+#endif
+
+void PerfCounters::printReport() {
+    if (!g_enabled) return;
+
+    PerfResults results = read();
+    std::cout << "Hardware counters (sort kernel replayed on the same input):\n";
+    if (!results.any()) {
+        std::cout << "  Not measured (the counters never ran)\n";
+        return;
+    }
+    if (results.has(PerfEvent::CYCLES))
+        std::cout << "  Cycles: " << results.get(PerfEvent::CYCLES) << "\n";
+    if (results.has(PerfEvent::INSTRUCTIONS))
+        std::cout << "  Instructions: " << results.get(PerfEvent::INSTRUCTIONS) << "\n";
+    if (results.ipc() > 0)
+        std::cout << "  IPC: " << std::fixed << std::setprecision(2) << results.ipc()
+                  << std::defaultfloat << "\n";
+    if (results.has(PerfEvent::BRANCH_MISSES))
+        std::cout << "  Branch misses: " << results.get(PerfEvent::BRANCH_MISSES) << "\n";
+    if (results.has(PerfEvent::L1D_MISSES))
+        std::cout << "  L1D read misses: " << results.get(PerfEvent::L1D_MISSES) << "\n";
+    if (results.has(PerfEvent::LLC_MISSES))
+        std::cout << "  LLC read misses: " << results.get(PerfEvent::LLC_MISSES) << "\n";
+    std::cout << "  (one counting window with no drawing, sound or delays -\n"
+              << "   toggling the counters per step would mostly measure the toggling)\n";
+    if (results.multiplexed)
+        std::cout << "  (counters were multiplexed - values are scaled estimates)\n";
+    if (!OPTIMIZED_BUILD)
+        std::cout << "  WARNING: unoptimized build - rebuild with -DCMAKE_BUILD_TYPE=Release\n"
+                  << "  for numbers that reflect the algorithm, not function call overhead\n";
+}
+
+void PerfCounters::recordRunTotals(long long comparisons, long long swaps, long long elapsedMs,
+                                   bool replayMatches) {
+    g_haveTotals = true;
+    g_comparisons = comparisons;
+    g_swaps = swaps;
+    g_elapsedMs = elapsedMs;
+    g_replayMatches = replayMatches;
+}
+
+bool PerfCounters::writeJson(const std::string& path, const std::string& algorithmName,
+                             int arraySize, int delayMs) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Could not write " << path << "\n";
+        return false;
+    }
+
+    PerfResults results = read();
+    out << "{\n";
+    out << "  \"algorithm\": \"" << algorithmName << "\",\n";
+    out << "  \"array_size\": " << arraySize << ",\n";
+    out << "  \"delay_ms\": " << delayMs << ",\n";
+    out << "  \"completed\": " << (g_haveTotals ? "true" : "false") << ",\n";
+    out << "  \"comparisons\": " << g_comparisons << ",\n";
+    out << "  \"swaps\": " << g_swaps << ",\n";
+    out << "  \"elapsed_ms\": " << g_elapsedMs << ",\n";
+    out << "  \"counters_available\": " << (results.any() ? "true" : "false");
+    if (results.any()) {
+        out << ",\n  \"replay_matches_run\": " << (g_replayMatches ? "true" : "false");
+    }
+
+    // Leave the numbers out entirely rather than writing zeros that look measured
+    if (results.any()) {
+        out << ",\n  \"optimized_build\": " << (OPTIMIZED_BUILD ? "true" : "false");
+        out << ",\n  \"multiplexed\": " << (results.multiplexed ? "true" : "false") << ",\n";
+        out << "  \"counters\": {";
+        bool first = true;
+        for (int e = 0; e < EVENT_COUNT; e++) {
+            PerfEvent event = static_cast<PerfEvent>(e);
+            if (!results.has(event)) continue;
+            out << (first ? "\n" : ",\n") << "    \"" << eventName(event) << "\": " << results.get(event);
+            first = false;
+        }
+        out << "\n  }";
+        if (results.ipc() > 0) {
+            out << ",\n  \"ipc\": " << std::fixed << std::setprecision(3) << results.ipc();
+        }
+        // Only meaningful if the counted replay did the same comparisons as the run
+        if (results.has(PerfEvent::INSTRUCTIONS) && g_replayMatches && g_comparisons > 0) {
+            out << ",\n  \"instructions_per_comparison\": " << std::fixed << std::setprecision(3)
+                << static_cast<double>(results.get(PerfEvent::INSTRUCTIONS)) / g_comparisons;
+        }
+    }
+    out << "\n";
+    out << "}\n";
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// Hardware counters we try to collect
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_MISSES,   // Level 1 data cache read misses
+    LLC_MISSES,   // Last level cache read misses
+    COUNT
+};
+
+// Counter totals for one sort run
+struct PerfResults {
+    bool available[static_cast<int>(PerfEvent::COUNT)] = {};
+    uint64_t values[static_cast<int>(PerfEvent::COUNT)] = {};
+    bool multiplexed = false;  // Counters shared the hardware, values are estimates
+
+    bool has(PerfEvent event) const { return available[static_cast<int>(event)]; }
+    uint64_t get(PerfEvent event) const { return values[static_cast<int>(event)]; }
+
+    // True if at least one counter was actually measured
+    bool any() const;
+
+    // Instructions per cycle, or 0 if either counter is missing
+    double ipc() const;
+};
+
+// Opt-in hardware performance counters (enable with --perf, Linux only)
+//
+// Uses perf_event_open to count user-space events for this process. The
+// counters only run inside a Scope. Turning them on and off around every
+// comparison would mostly measure the ioctl calls and leave the caches and
+// branch predictor full of drawing code, so each algorithm instead replays
+// its input through a plain kernel (no viz) inside one Scope.
+//
+// Usage inside an algorithm:
+//   std::vector<int> perfInput = array;      // before sorting
+//   ...visualized sort...
+//   PerfCounters::reset();
+//   {
+//       PerfCounters::Scope perfScope;       // counted
+//       mySortKernel(perfInput);
+//   }
+class PerfCounters {
+public:
+    // Open the counters. Returns false (and prints why) if they aren't available.
+    static bool enable();
+    static bool isEnabled();
+
+    // Zero all counters (e.g. at the start of a sort)
+    static void reset();
+
+    // Counter values from the last Scope since reset(). Nothing is marked
+    // available if no Scope ran (e.g. the sort was quit early) or if the
+    // kernel never got the counters onto the hardware.
+    static PerfResults read();
+
+    static std::string eventName(PerfEvent event);
+
+    // Print the counters as part of the end-of-run summary
+    static void printReport();
+
+    // Remember the sort's own totals so writeJson can include them
+    // (call from the end-of-run summary; not calling it marks the run incomplete).
+    // replayMatches says the counted replay did exactly the same comparisons and swaps.
+    static void recordRunTotals(long long comparisons, long long swaps, long long elapsedMs,
+                                bool replayMatches);
+
+    // Write the run totals and counters to a JSON file for benchmarking scripts
+    static bool writeJson(const std::string& path, const std::string& algorithmName,
+                          int arraySize, int delayMs);
+
+    // Counters run while this is alive
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+#endif // PERF_COUNTERS_H
@@ -9,6 +9,7 @@
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include "alloc_tracker.h"
 
 // Configuration - Students can change these!
 const int ARRAY_SIZE = 100;
@@ -96,17 +97,24 @@ private:
     void renderText(const std::string& text, int x, int y, SDL_Color color) {
         SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
         if (!surface) return;
+        size_t surfaceBytes = surface->pitch * surface->h;
+        AllocTracker::recordSdlSurface(surfaceBytes);
 
         SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
         if (!texture) {
+            AllocTracker::releaseSdlSurface(surfaceBytes);
             SDL_FreeSurface(surface);
             return;
         }
+        size_t textureBytes = surface->w * surface->h * 4;  // Texture is 32-bit RGBA
+        AllocTracker::recordSdlTexture(textureBytes);
 
         SDL_Rect rect = {x, y, surface->w, surface->h};
         SDL_RenderCopy(renderer, texture, nullptr, &rect);
 
+        AllocTracker::releaseSdlTexture(textureBytes);
         SDL_DestroyTexture(texture);
+        AllocTracker::releaseSdlSurface(surfaceBytes);
         SDL_FreeSurface(surface);
     }
 
@@ -219,6 +227,8 @@ public:
     // Draw the array with optional highlighting
     void draw(const std::vector<int>& array, int compareIdx1 = -1, int compareIdx2 = -1,
               const std::vector<bool>& sorted = {}) {
+        AllocTracker::Scope allocScope(AllocCategory::RENDER);
+
         // Clear screen with dark background
         SDL_SetRenderDrawColor(renderer, 20, 20, 30, 255);
         SDL_RenderClear(renderer);
@@ -263,6 +273,12 @@ public:
 
         ss.str("");
         ss << "Space Complexity: " << spaceComplexity;
+        if (AllocTracker::isEnabled()) {
+            // Show what the sort has really allocated next to the textbook answer
+            ss << " (measured: "
+               << AllocTracker::formatBytes(AllocTracker::getStats(AllocCategory::SORT).peakBytes)
+               << " peak)";
+        }
         renderText(ss.str(), 10, 60, textColor);
 
         ss.str("");